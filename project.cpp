@@ -5,6 +5,24 @@
 #include <vector>
 #include <map>
 #include <cmath>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <cstdlib>
+#include <sys/resource.h>
 
 using namespace std;
 
@@ -25,24 +43,606 @@ struct Student {
     vector<SubjectInfo> subjects;  // same order as global subjectNames
 };
 
-map<int, Student> DB;          // roll -> student
+// ============== ROSTER VERSIONS ==============
+
+// Persistent AVL tree keyed by roll. Saving a student copies only the
+// O(log n) nodes on the path to it; every other node and every Student is
+// shared with the version it came from, so old versions stay around for
+// almost nothing and switching between them never copies the roster.
+class Roster {
+    struct Node;
+    typedef shared_ptr<const Node> Link;
+
+    struct Node {
+        int                       roll;
+        shared_ptr<const Student> student;
+        Link                      left, right;
+        int                       height;
+        size_t                    count;
+
+        // nodes alive across all versions; atomic because the saved roster
+        // is built on the loader thread while the UI commits edits
+        static inline atomic<size_t> live{0};
+
+        Node(int r, shared_ptr<const Student> s, Link l, Link rt)
+            : roll(r), student(std::move(s)), left(std::move(l)), right(std::move(rt))
+        {
+            height = 1 + max(Roster::height(left), Roster::height(right));
+            count  = 1 + Roster::count(left) + Roster::count(right);
+            live.fetch_add(1, memory_order_relaxed);
+        }
+        ~Node() { live.fetch_sub(1, memory_order_relaxed); }
+    };
+
+    Link root;
+
+    static int    height(const Link &n) { return n ? n->height : 0; }
+    static size_t count(const Link &n)  { return n ? n->count  : 0; }
+
+    static Link make(int roll, shared_ptr<const Student> s, Link l, Link r) {
+        return make_shared<const Node>(roll, std::move(s), std::move(l), std::move(r));
+    }
+
+    // Rebuild a node whose subtrees may differ in height by two.
+    static Link balance(int roll, const shared_ptr<const Student> &s,
+                        const Link &l, const Link &r)
+    {
+        if (height(l) > height(r) + 1) {
+            if (height(l->left) >= height(l->right))
+                return make(l->roll, l->student, l->left,
+                            make(roll, s, l->right, r));
+            const Link &lr = l->right;
+            return make(lr->roll, lr->student,
+                        make(l->roll, l->student, l->left, lr->left),
+                        make(roll, s, lr->right, r));
+        }
+        if (height(r) > height(l) + 1) {
+            if (height(r->right) >= height(r->left))
+                return make(r->roll, r->student,
+                            make(roll, s, l, r->left), r->right);
+            const Link &rl = r->left;
+            return make(rl->roll, rl->student,
+                        make(roll, s, l, rl->left),
+                        make(r->roll, r->student, rl->right, r->right));
+        }
+        return make(roll, s, l, r);
+    }
+
+    static Link insert(const Link &n, int roll, const shared_ptr<const Student> &s) {
+        if (!n) return make(roll, s, nullptr, nullptr);
+        if (roll < n->roll)
+            return balance(n->roll, n->student, insert(n->left, roll, s), n->right);
+        if (roll > n->roll)
+            return balance(n->roll, n->student, n->left, insert(n->right, roll, s));
+        return make(roll, s, n->left, n->right);
+    }
+
+    static Link buildSorted(vector<pair<int, Student>> &items, size_t lo, size_t hi) {
+        if (lo >= hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        Link l = buildSorted(items, lo, mid);
+        Link r = buildSorted(items, mid + 1, hi);
+        return make(items[mid].first,
+                    make_shared<const Student>(std::move(items[mid].second)), l, r);
+    }
+
+    // Insert into out every student of n that before doesn't hold as-is.
+    static void addChanges(const Link &n, const Roster &before, Link &out) {
+        if (!n) return;
+        addChanges(n->left, before, out);
+        if (before.find(n->roll) != n->student.get())
+            out = insert(out, n->roll, n->student);
+        addChanges(n->right, before, out);
+    }
+
+    template <class F>
+    static void walk(const Link &n, F &f) {
+        if (!n) return;
+        walk(n->left, f);
+        f(n->roll, *n->student);
+        walk(n->right, f);
+    }
+
+public:
+    const Student* find(int roll) const {
+        const Node *n = root.get();
+        while (n) {
+            if      (roll < n->roll) n = n->left.get();
+            else if (roll > n->roll) n = n->right.get();
+            else return n->student.get();
+        }
+        return nullptr;
+    }
+
+    bool contains(int roll) const { return find(roll) != nullptr; }
+
+    // Student with that roll, or a blank one if this version lacks it.
+    const Student& at(int roll) const {
+        static const Student blank;
+        const Student *s = find(roll);
+        return s ? *s : blank;
+    }
+
+    // New version with roll added or replaced; this one is left untouched.
+    Roster with(int roll, const Student &s) const {
+        Roster r;
+        r.root = insert(root, roll, make_shared<const Student>(s));
+        return r;
+    }
+
+    // This version plus what `after` added or replaced relative to `before`.
+    // Those students are shared with `after`, not copied.
+    Roster withChanges(const Roster &before, const Roster &after) const {
+        Roster r = *this;
+        addChanges(after.root, before, r.root);
+        return r;
+    }
+
+    size_t size() const { return count(root); }
+
+    // Balanced tree straight from entries sorted by unique roll, in O(n).
+    static Roster fromSorted(vector<pair<int, Student>> items) {
+        Roster r;
+        r.root = buildSorted(items, 0, items.size());
+        return r;
+    }
+
+    // Visit f(roll, student) in roll order.
+    template <class F>
+    void forEach(F f) const { walk(root, f); }
+
+    // Identifies the tree. Only stable while some copy of this Roster is
+    // alive; a freed root's address can come back for another version.
+    const void* id() const { return root.get(); }
+
+    static size_t liveNodes() { return Node::live.load(memory_order_relaxed); }
+    static size_t nodeBytes() { return sizeof(Node); }
+};
+
+// Every committed roster, oldest first; nothing is ever dropped. Version 0
+// is the empty or saved roster and each save appends a version made from the
+// current one, so saving after an undo or a jump starts a branch instead of
+// discarding newer versions. Undo steps back to the version a save was made
+// from and redo retraces those steps; jumping only moves the head.
+class RosterHistory {
+public:
+    const Roster& current() const { return versions[head]; }
+    size_t version() const { return head; }
+    size_t latest()  const { return versions.size() - 1; }
+    const Roster& newest() const { return versions.back(); }
+
+    // Append r as the newest version, made from the current one.
+    void commit(Roster r) {
+        versions.push_back(std::move(r));
+        parents.push_back(head);
+        head = latest();
+        redoSteps.clear();
+    }
+
+    // Make base version 0, so it can't be undone, and replay each later
+    // save on top of its parent in commit order. Only the rolls a save
+    // changed are re-inserted, so versions keep sharing base's nodes.
+    void rebase(const Roster &base) {
+        vector<Roster> old = std::move(versions);
+        versions.assign(1, base.withChanges(Roster(), old[0]));
+        for (size_t v = 1; v < old.size(); ++v)
+            versions.push_back(versions[parents[v]].withChanges(old[parents[v]], old[v]));
+    }
+
+    bool undo() {
+        if (head == 0) return false;
+        redoSteps.push_back(head);
+        head = parents[head];
+        return true;
+    }
+
+    bool redo() {
+        if (redoSteps.empty()) return false;
+        head = redoSteps.back();
+        redoSteps.pop_back();
+        return true;
+    }
+
+    bool jumpTo(size_t v) {
+        if (v > latest()) return false;
+        head = v;
+        redoSteps.clear();
+        return true;
+    }
+
+private:
+    vector<Roster> versions{Roster()};
+    vector<size_t> parents{0};     // version each one was saved from
+    vector<size_t> redoSteps;      // versions undo walked away from
+    size_t head = 0;
+};
+
+RosterHistory roster;          // roll -> student, every saved version
 vector<string> subjectNames;   // defined once at start
 
+// ============== STUDENT SEARCH ===============
+
+// Typo-tolerant lookup by roll prefix or name. Every student is keyed as
+// "<roll> <lowercase name>" and the query is matched with a Levenshtein DP
+// that may start at any word, so "1235" still finds 1234 and "jhon" finds
+// "John Smith". Candidates start from an index of word initials instead of
+// every student; words whose first letter was the typo are added (via an
+// index of second letters) at the third character, only when the two
+// characters after it are right, and shown only if the rest find too few.
+// Each typed character keeps one DP row per surviving candidate, so the
+// next keystroke only extends those rows and a backspace just drops the
+// last layer.
+
+struct SearchHit {
+    int  roll;
+    int  dist;
+    bool firstTypo = false;   // found only by allowing a wrong first letter
+};
+
+class StudentSearch {
+public:
+    static constexpr int    MAX_DIST = 2;   // worst typo count ever kept
+    static constexpr size_t MAX_HITS = 6;   // candidates shown under the input
+
+    // Bring the search in line with the typed text, reusing every layer
+    // that shares a prefix with it. The index is rebuilt whenever a
+    // different roster version is passed in.
+    const vector<SearchHit>& update(const Roster &r, const string &text) {
+        if (!built || r.id() != builtFrom.id()) {
+            build(r);
+            widenedAt = 0;
+            layers.clear();
+            query.clear();
+            results.clear();
+        }
+
+        size_t common = 0;
+        while (common < query.size() && common < text.size() &&
+               query[common] == (char)tolower((unsigned char)text[common]))
+            common++;
+        if (common == query.size() && common == text.size())
+            return results;
+
+        layers.resize(common);
+        query.resize(common);
+        if (common < widenedAt) unwiden();
+        for (size_t i = common; i < text.size(); ++i)
+            extend((char)tolower((unsigned char)text[i]));
+        rank();
+        return results;
+    }
+
+    const vector<SearchHit>& hits() const { return results; }
+
+private:
+    struct Key {
+        int    roll;
+        size_t start;   // into pool
+        size_t len;
+    };
+
+    // Candidates still within MAX_DIST after query[0..i]. Their DP rows are
+    // packed into one buffer (key.len+1 cells each, found through off), and
+    // parent points at the same key in the layer below. The first `exact`
+    // entries grew from byInitial[query[0]], the rest were added by widen().
+    struct Layer {
+        size_t          exact = 0;
+        vector<int>     ids;
+        vector<int>     parent;
+        vector<size_t>  off;
+        vector<uint8_t> dist;
+        vector<uint8_t> rows;
+    };
+
+    vector<Key>       keys;
+    string            pool;     // all key texts back to back
+    vector<int>       byInitial[256];   // key ids with a word starting with c
+    vector<int>       bySecond[256];    // key ids with a word whose 2nd char is c
+    vector<uint8_t>   mark;             // per key, scratch for de-duplicating
+    size_t            widenedAt = 0;    // query length widen() ran at, 0 if not
+    vector<Layer>     layers;   // layers[i] matches query[0..i]
+    string            query;
+    vector<SearchHit> results;
+    vector<uint8_t>   scratch, scratch2;
+    bool              built = false;
+    Roster            builtFrom;   // held so its root address can't be reused
+
+    void build(const Roster &r) {
+        keys.clear();
+        pool.clear();
+        for (auto &ids : byInitial) ids.clear();
+        for (auto &ids : bySecond)  ids.clear();
+        keys.reserve(r.size());
+        r.forEach([&](int roll, const Student &st) {
+            Key k;
+            k.roll  = roll;
+            k.start = pool.size();
+            pool += to_string(roll);
+            pool += ' ';
+            for (char c : st.name)
+                pool.push_back((char)tolower((unsigned char)c));
+            k.len = pool.size() - k.start;
+            for (size_t j = k.start; j < pool.size(); ++j) {
+                if (j > k.start && pool[j-1] != ' ') continue;
+                vector<int> &ids = byInitial[(uint8_t)pool[j]];
+                if (ids.empty() || ids.back() != (int)keys.size())
+                    ids.push_back((int)keys.size());
+                if (j + 1 < pool.size() && pool[j+1] != ' ') {
+                    vector<int> &ids2 = bySecond[(uint8_t)pool[j+1]];
+                    if (ids2.empty() || ids2.back() != (int)keys.size())
+                        ids2.push_back((int)keys.size());
+                }
+            }
+            keys.push_back(k);
+        });
+        mark.assign(keys.size(), 0);
+        built = true;
+        builtFrom = r;
+    }
+
+    // Row for the empty query: zero at every word start, so a match may
+    // begin at the roll or at any part of the name.
+    static const uint8_t* firstRow(const char *key, size_t len, vector<uint8_t> &buf) {
+        buf.resize(len + 1);
+        buf[0] = 0;
+        for (size_t j = 1; j <= len; ++j) {
+            int v = (key[j-1] == ' ') ? 0 : buf[j-1] + 1;
+            buf[j] = (uint8_t)min(v, MAX_DIST + 1);
+        }
+        return buf.data();
+    }
+
+    // One DP row for query char c on top of row up. up2 is the row two
+    // characters back (for swapped letters, may be null) and last the query
+    // char before c. Returns the row minimum.
+    static int stepRow(const char *key, size_t len, const uint8_t *up,
+                       const uint8_t *up2, char c, char last, uint8_t *cur)
+    {
+        const int cap = MAX_DIST + 1;
+        cur[0] = (uint8_t)min(up[0] + 1, cap);
+        int best = cur[0];
+        for (size_t j = 1; j < len; ++j) {
+            int v = up[j-1] + (key[j-1] != c ? 1 : 0);
+            v = min(v, up[j] + 1);
+            v = min(v, cur[j-1] + 1);
+            if (up2 && j >= 2 && key[j-2] == c && key[j-1] == last)
+                v = min(v, up2[j-2] + 1);
+            cur[j] = (uint8_t)min(v, cap);
+            best = min(best, v);
+        }
+        return best;
+    }
+
+    // Whether some word of the key reads as q[0..2] with only the first
+    // character wrong: mistyped (?q1q2), stray (q1q2), missed (?q0q1q2) or
+    // swapped with the second (q1q0q2).
+    static bool firstTypoFits(const char *key, size_t len, const char *q) {
+        for (size_t j = 0; j < len; ++j) {
+            if (j > 0 && key[j-1] != ' ') continue;
+            auto at = [&](size_t i) { return j + i < len ? key[j+i] : '\0'; };
+            if ((at(1) == q[1] && at(2) == q[2]) ||
+                (at(0) == q[1] && at(1) == q[2]) ||
+                (at(1) == q[0] && at(2) == q[1] && at(3) == q[2]) ||
+                (at(0) == q[1] && at(1) == q[0] && at(2) == q[2]))
+                return true;
+        }
+        return false;
+    }
+
+    // The layers only follow words starting with query[0]. Add the words
+    // where query[0] is the typo, found through second letter query[1]
+    // (first one mistyped), initial query[1] (a stray char typed first) or
+    // second letter query[0] (first one missed or swapped). Only keys that
+    // fit one of those with query[1..2] right get rows. Their rows are
+    // computed for every layer, so later keystrokes extend them like any
+    // other candidate.
+    void widen() {
+        char q0 = query[0], q1 = query[1];
+        const vector<int> &exact = byInitial[(uint8_t)q0];
+        for (int id : exact) mark[id] = 1;
+
+        vector<int> added;
+        const vector<int> *lists[] = { &bySecond[(uint8_t)q1], &byInitial[(uint8_t)q1],
+                                       &bySecond[(uint8_t)q0] };
+        for (const vector<int> *list : lists) {
+            for (int id : *list) {
+                if (mark[id]) continue;
+                const char *key = pool.data() + keys[id].start;
+                size_t len = keys[id].len + 1;
+                if (!firstTypoFits(key, len - 1, query.data())) continue;
+                mark[id] = 1;
+                added.push_back(id);
+
+                const uint8_t *first = firstRow(key, len - 1, scratch);
+                for (size_t m = 1; m <= query.size(); ++m) {
+                    Layer &l = layers[m-1];
+                    const uint8_t *up = m == 1 ? first : &layers[m-2].rows[layers[m-2].off.back()];
+                    const uint8_t *up2 = nullptr;
+                    if (m == 2)     up2 = first;
+                    else if (m > 2) up2 = &layers[m-3].rows[layers[m-3].off.back()];
+
+                    size_t at = l.rows.size();
+                    l.rows.resize(at + len);
+                    int best = stepRow(key, len, up, up2, query[m-1],
+                                       m >= 2 ? query[m-2] : 0, &l.rows[at]);
+                    if (best > MAX_DIST) {
+                        l.rows.resize(at);
+                        break;
+                    }
+                    l.ids.push_back(id);
+                    l.parent.push_back(m == 1 ? -1 : (int)layers[m-2].ids.size() - 1);
+                    l.off.push_back(at);
+                    l.dist.push_back((uint8_t)best);
+                }
+            }
+        }
+
+        for (int id : exact) mark[id] = 0;
+        for (int id : added) mark[id] = 0;
+        widenedAt = query.size();
+    }
+
+    // Drop what widen() added from every layer once the text is shorter
+    // than when it ran, so the next rank() decides afresh.
+    void unwiden() {
+        widenedAt = 0;
+        for (Layer &l : layers) {
+            if (l.ids.size() == l.exact) continue;
+            l.rows.resize(l.off[l.exact]);
+            l.ids.resize(l.exact);
+            l.parent.resize(l.exact);
+            l.off.resize(l.exact);
+            l.dist.resize(l.exact);
+        }
+    }
+
+    // Add one query character. Rows come from the layer below (and the one
+    // under it, for swapped letters), so only survivors are touched.
+    void extend(char c) {
+        size_t m = query.size() + 1;   // query length after this char
+        const Layer *prev  = m >= 2 ? &layers[m-2] : nullptr;
+        const Layer *prev2 = m >= 3 ? &layers[m-3] : nullptr;
+        char last = m >= 2 ? query[m-2] : 0;
+        const vector<int> &initial = byInitial[(uint8_t)c];
+        size_t n = prev ? prev->ids.size() : initial.size();
+        size_t exact = prev ? prev->exact : n;
+
+        Layer next;
+        next.rows.resize(prev ? prev->rows.size() : pool.size() + keys.size());
+        size_t used = 0;
+
+        for (size_t k = 0; k < n; ++k) {
+            int id = prev ? prev->ids[k] : initial[k];
+            const char *key = pool.data() + keys[id].start;
+            size_t len = keys[id].len + 1;
+
+            const uint8_t *up = prev ? &prev->rows[prev->off[k]]
+                                     : firstRow(key, len - 1, scratch);
+            const uint8_t *up2 = nullptr;
+            if (prev2)      up2 = &prev2->rows[prev2->off[prev->parent[k]]];
+            else if (prev)  up2 = firstRow(key, len - 1, scratch2);
+
+            int best = stepRow(key, len, up, up2, c, last, &next.rows[used]);
+            if (best <= MAX_DIST) {
+                if (k < exact) next.exact++;
+                next.ids.push_back(id);
+                next.parent.push_back((int)k);
+                next.off.push_back(used);
+                next.dist.push_back((uint8_t)best);
+                used += len;
+            }
+        }
+        next.rows.resize(used);
+
+        query.push_back(c);
+        layers.push_back(std::move(next));
+    }
+
+    // Short queries must match exactly; longer ones tolerate a typo or two.
+    static int allowedDist(size_t len) {
+        if (len < 3) return 0;
+        if (len < 6) return 1;
+        return MAX_DIST;
+    }
+
+    void rank() {
+        results.clear();
+        if (layers.empty()) return;
+
+        const Layer &top = layers.back();
+        int allowed = allowedDist(query.size());
+        for (size_t k = 0; k < top.exact; ++k)
+            if (top.dist[k] <= allowed)
+                results.push_back({keys[top.ids[k]].roll, top.dist[k]});
+
+        // Candidates for a wrong first letter are added as soon as typos
+        // are allowed, while there are only three layers to fill, but they
+        // only count when the right first letter leaves too few hits.
+        if (allowed > 0 && !widenedAt) widen();
+        if (results.size() < MAX_HITS && allowed > 0) {
+            for (size_t k = top.exact; k < top.ids.size(); ++k)
+                if (top.dist[k] <= allowed)
+                    results.push_back({keys[top.ids[k]].roll, top.dist[k], true});
+        }
+
+        auto better = [](const SearchHit &a, const SearchHit &b) {
+            if (a.dist != b.dist) return a.dist < b.dist;
+            if (a.firstTypo != b.firstTypo) return b.firstTypo;
+            return a.roll < b.roll;
+        };
+        size_t keep = min(MAX_HITS, results.size());
+        partial_sort(results.begin(), results.begin() + keep, results.end(), better);
+        results.resize(keep);
+    }
+};
+
 // ============== FONT ========================
 
+// Places to look for the UI font, first existing file wins. main() puts
+// --font, $SRMS_FONT and the path remembered by the warm-start file in
+// front of these before anything is drawn.
+vector<string> fontCandidates = {
+    "/System/Library/Fonts/Supplemental/Arial.ttf",
+    "/Library/Fonts/Arial.ttf",
+    "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/TTF/DejaVuSans.ttf",
+    "/usr/share/fonts/dejavu/DejaVuSans.ttf",
+    "/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+    "/usr/share/fonts/liberation-sans/LiberationSans-Regular.ttf",
+    "/usr/share/fonts/truetype/noto/NotoSans-Regular.ttf",
+    "/usr/share/fonts/noto/NotoSans-Regular.ttf",
+    "C:/Windows/Fonts/arial.ttf"
+};
+
+// Resolved once; "" if none of the candidates exist.
+const string& fontPath() {
+    static const string found = [] {
+        for (auto &p : fontCandidates) {
+            error_code ec;
+            if (!p.empty() && filesystem::is_regular_file(p, ec)) return p;
+        }
+        return string();
+    }();
+    return found;
+}
+
+// One font per thread: sf::Font fills its glyph pages lazily, so render
+// threads must not share it.
 sf::Font& appFont() {
-    static sf::Font font;
-    static bool loaded = false;
+    static thread_local sf::Font font;
+    static thread_local bool loaded = false;
     if (!loaded) {
-        font.loadFromFile("/System/Library/Fonts/Supplemental/Arial.ttf");
+        if (!fontPath().empty()) font.loadFromFile(fontPath());
         loaded = true;
     }
     return font;
 }
 
+// Rasterises printable ASCII at every text size the UI uses, a slice per
+// frame, so opening a screen for the first time doesn't stall on FreeType.
+class GlyphPrebake {
+public:
+    bool done() const { return sizeIdx >= sizes.size(); }
+
+    void step(double budgetMs) {
+        auto start = chrono::steady_clock::now();
+        while (!done()) {
+            appFont().getGlyph(ch, sizes[sizeIdx], false);
+            if (++ch > 126) { ch = 32; sizeIdx++; }
+            if (chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() > budgetMs)
+                break;
+        }
+    }
+
+private:
+    vector<unsigned> sizes = {18, 20, 22, 24, 26, 28, 34};
+    size_t sizeIdx = 0;
+    sf::Uint32 ch = 32;
+};
+
 // ============== UI HELPERS ===================
 
-void drawCenteredText(sf::RenderWindow &win,
+void drawCenteredText(sf::RenderTarget &win,
                       const string &text,
                       float y,
                       unsigned int size,
@@ -59,7 +659,7 @@ void drawCenteredText(sf::RenderWindow &win,
     win.draw(t);
 }
 
-void drawLeftText(sf::RenderWindow &win,
+void drawLeftText(sf::RenderTarget &win,
                   const string &text,
                   float x,
                   float y,
@@ -75,7 +675,7 @@ void drawLeftText(sf::RenderWindow &win,
     win.draw(t);
 }
 
-void drawCardCentered(sf::RenderWindow &win, float w, float h)
+void drawCardCentered(sf::RenderTarget &win, float w, float h)
 {
     float W = win.getSize().x;
     float H = win.getSize().y;
@@ -95,9 +695,17 @@ void drawCardCentered(sf::RenderWindow &win, float w, float h)
     win.draw(card);
 }
 
-bool drawButtonCentered(sf::RenderWindow &win,
+// Mouse as the buttons see it. clicked is set by a press and cleared once
+// the frame is drawn, so one click triggers one button.
+struct Pointer {
+    sf::Vector2f pos;
+    bool clicked = false;
+};
+
+bool drawButtonCentered(sf::RenderTarget &win,
                         const string &label,
-                        float centerY)
+                        float centerY,
+                        const Pointer &ptr)
 {
     float W = win.getSize().x;
     float bw = 360.f;
@@ -107,8 +715,7 @@ bool drawButtonCentered(sf::RenderWindow &win,
     box.setOrigin(bw / 2.f, bh / 2.f);
     box.setPosition(W / 2.f, centerY);
 
-    sf::Vector2i mp = sf::Mouse::getPosition(win);
-    bool hover = box.getGlobalBounds().contains((float)mp.x, (float)mp.y);
+    bool hover = box.getGlobalBounds().contains(ptr.pos.x, ptr.pos.y);
 
     box.setFillColor(hover ? sf::Color(235, 210, 255) : sf::Color(220, 195, 255));
     box.setOutlineThickness(hover ? 4.f : 3.f);
@@ -125,12 +732,12 @@ bool drawButtonCentered(sf::RenderWindow &win,
     t.setPosition(W / 2.f, centerY - 3.f);
     win.draw(t);
 
-    if (hover && sf::Mouse::isButtonPressed(sf::Mouse::Left))
+    if (hover && ptr.clicked)
         return true;
     return false;
 }
 
-void drawInputCard(sf::RenderWindow &win,
+void drawInputCard(sf::RenderTarget &win,
                    const string &title,
                    const string &prompt,
                    const string &current)
@@ -149,7 +756,50 @@ void drawInputCard(sf::RenderWindow &win,
         top + 170.f, 18, sf::Color(80, 60, 130));
 }
 
-void drawMessageCard(sf::RenderWindow &win,
+void drawSearchCard(sf::RenderTarget &win,
+                    const string &title,
+                    const string &current,
+                    const vector<SearchHit> &hits,
+                    int selected)
+{
+    float cardW = min(640.f, win.getSize().x * 0.85f);
+    float cardH = 230.f + 30.f * StudentSearch::MAX_HITS;
+    drawCardCentered(win, cardW, cardH);
+    float W = win.getSize().x;
+    float H = win.getSize().y;
+    float top = (H - cardH) / 2.f;
+    float left = W / 2.f - cardW / 2.f + 40.f;
+
+    drawCenteredText(win, title,   top + 30.f, 26, sf::Color(60, 0, 110));
+    drawCenteredText(win, "Enter Roll Number or Name:",
+                     top + 75.f, 22, sf::Color(40, 0, 90));
+    drawCenteredText(win, current, top + 125.f, 28, sf::Color(0, 100, 40));
+
+    float y = top + 160.f;
+    if (hits.empty() && !current.empty())
+        drawCenteredText(win, "No matching students", y + 15.f, 18,
+                         sf::Color(150, 60, 90));
+
+    for (size_t i = 0; i < hits.size(); ++i) {
+        if ((int)i == selected) {
+            sf::RectangleShape bar(sf::Vector2f(cardW - 80.f, 28.f));
+            bar.setPosition(left, y);
+            bar.setFillColor(sf::Color(220, 195, 255));
+            win.draw(bar);
+        }
+        const Student &s = roster.current().at(hits[i].roll);
+        string line = to_string(hits[i].roll) + "   " + s.name;
+        if (hits[i].dist > 0) line += "   (close match)";
+        drawLeftText(win, line, left + 10.f, y + 2.f, 18);
+        y += 30.f;
+    }
+
+    drawCenteredText(win,
+        "Type to search, UP/DOWN to pick, ENTER to open",
+        top + cardH - 30.f, 18, sf::Color(80, 60, 130));
+}
+
+void drawMessageCard(sf::RenderTarget &win,
                      const string &title,
                      const string &msg)
 {
@@ -178,7 +828,7 @@ vector<sf::Color> pieColors() {
 }
 
 // PIE CHART
-void drawPieChart(sf::RenderWindow &win, const Student &s)
+void drawPieChart(sf::RenderTarget &win, const Student &s)
 {
     if (s.subjects.empty()) return;
 
@@ -225,6 +875,62 @@ void drawPieChart(sf::RenderWindow &win, const Student &s)
     win.draw(inner);
 }
 
+// Pie chart card with title, legend and an optional footer line. Used by
+// PIE_SHOW and by the offscreen chart renderer.
+void drawPieCard(sf::RenderTarget &win,
+                 int roll,
+                 const Student &s,
+                 const string &footer)
+{
+    float cardW = min(820.f, win.getSize().x*0.95f);
+    float cardH = 550.f;
+    drawCardCentered(win, cardW, cardH);
+
+    float H = win.getSize().y;
+    float top = (H-cardH)/2.f;
+
+    drawCenteredText(win, "Attendance Pie Chart",
+                     top+40.f, 26, sf::Color(60,0,110));
+
+    drawCenteredText(win,
+        "Roll : " + to_string(roll) +
+        "   Name : " + s.name,
+        top+80.f, 20);
+
+    // PIE
+    drawPieChart(win, s);
+
+    // LEGEND
+    auto cols = pieColors();
+    float startY = top + 280.f;
+    float startX = win.getSize().x / 2.f - 260.f;
+
+    int i = 0;
+    for (auto &sub : s.subjects) {
+        float per = (sub.total>0) ? (100.f*sub.present/sub.total) : 0.f;
+
+        sf::RectangleShape box(sf::Vector2f(18.f,18.f));
+        box.setFillColor(cols[i % cols.size()]);
+        box.setPosition(startX, startY - 14.f);
+        win.draw(box);
+
+        string text = sub.name + "  →  " +
+                      to_string(per).substr(0,5) + "%";
+        drawLeftText(win, text, startX+30.f, startY-16.f, 18,
+                     sf::Color::Black);
+
+        startY += 26.f;
+        i++;
+    }
+
+    drawCenteredText(win,
+        "Each color represents one subject and its attendance percentage",
+        top+cardH-70.f, 18, sf::Color(40,0,80));
+    if (!footer.empty())
+        drawCenteredText(win, footer,
+                         top+cardH-40.f, 18, sf::Color(80,60,130));
+}
+
 // ============== STATE MACHINE =====================
 
 enum class Screen {
@@ -243,7 +949,9 @@ enum class Screen {
     VIEW_ATT_SHOW,
 
     PIE_ROLL,
-    PIE_SHOW
+    PIE_SHOW,
+
+    VERSION_PICK   // jump the roster to an earlier/later version
 };
 
 enum class AddStep {
@@ -260,15 +968,30 @@ enum class AttendStep {
     PRESENT
 };
 
-// ============== MAIN =============================
+const char* screenName(Screen s) {
+    switch (s) {
+        case Screen::SUBJECT_COUNT:     return "SUBJECT_COUNT";
+        case Screen::SUBJECT_NAME:      return "SUBJECT_NAME";
+        case Screen::MENU:              return "MENU";
+        case Screen::MSG:               return "MSG";
+        case Screen::ADD_BASIC:         return "ADD_BASIC";
+        case Screen::ADD_ATTEND:        return "ADD_ATTEND";
+        case Screen::VIEW_DETAILS_ROLL: return "VIEW_DETAILS_ROLL";
+        case Screen::VIEW_DETAILS_SHOW: return "VIEW_DETAILS_SHOW";
+        case Screen::VIEW_ATT_ROLL:     return "VIEW_ATT_ROLL";
+        case Screen::VIEW_ATT_SHOW:     return "VIEW_ATT_SHOW";
+        case Screen::PIE_ROLL:          return "PIE_ROLL";
+        case Screen::PIE_SHOW:          return "PIE_SHOW";
+        case Screen::VERSION_PICK:      return "VERSION_PICK";
+    }
+    return "?";
+}
 
-int main() {
-    sf::RenderWindow win(sf::VideoMode(1000, 700),
-                         "Student Record Management System",
-                         sf::Style::Default);
-    win.setFramerateLimit(60);
-    sf::View view = win.getView();
+// ============== APP =============================
 
+// One running UI: the current screen plus everything typed so far. The live
+// window and the replay driver both feed it events, then update and draw it.
+struct App {
     Screen screen = Screen::SUBJECT_COUNT;  // first: setup subjects
     AddStep addStep = AddStep::ROLL;
     AttendStep attendStep = AttendStep::TOTAL;
@@ -286,470 +1009,1428 @@ int main() {
 
     // view / pie
     int currentRoll = -1;
+    StudentSearch search;
+    int searchSel = 0;
 
-    while (win.isOpen()) {
-        bool enterPressed = false;
-
-        // Which input string is currently active?
-        string* activeInput = nullptr;
-        switch (screen) {
-            case Screen::SUBJECT_COUNT:
-            case Screen::SUBJECT_NAME:
-            case Screen::ADD_BASIC:
-            case Screen::ADD_ATTEND:
-            case Screen::VIEW_DETAILS_ROLL:
-            case Screen::VIEW_ATT_ROLL:
-            case Screen::PIE_ROLL:
-                activeInput = &input;
-                break;
-            default:
-                activeInput = nullptr;
+    Pointer pointer;
+    bool enterPressed = false;
+    bool rosterLoading = false;   // warm-start roster still being read
+
+    bool typing() const;                     // does this screen take text?
+    void handleEvent(const sf::Event &event);
+    void update();                           // logic once a frame's events are in
+    void draw(sf::RenderTarget &win);
+};
+
+bool App::typing() const {
+    switch (screen) {
+        case Screen::SUBJECT_COUNT:
+        case Screen::SUBJECT_NAME:
+        case Screen::ADD_BASIC:
+        case Screen::ADD_ATTEND:
+        case Screen::VIEW_DETAILS_ROLL:
+        case Screen::VIEW_ATT_ROLL:
+        case Screen::PIE_ROLL:
+        case Screen::VERSION_PICK:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void App::handleEvent(const sf::Event &event) {
+    if (event.type == sf::Event::MouseMoved)
+        pointer.pos = sf::Vector2f((float)event.mouseMove.x, (float)event.mouseMove.y);
+
+    if (event.type == sf::Event::MouseButtonPressed &&
+        event.mouseButton.button == sf::Mouse::Left)
+    {
+        pointer.pos = sf::Vector2f((float)event.mouseButton.x, (float)event.mouseButton.y);
+        pointer.clicked = true;
+    }
+
+    if (event.type == sf::Event::KeyPressed) {
+        if (event.key.code == sf::Keyboard::Enter)
+            enterPressed = true;
+
+        if (event.key.code == sf::Keyboard::Escape &&
+            screen != Screen::SUBJECT_COUNT &&
+            screen != Screen::SUBJECT_NAME &&
+            screen != Screen::MSG)
+        {
+            screen = Screen::MENU;
+            input.clear();
         }
 
-        sf::Event event;
-        while (win.pollEvent(event)) {
-            if (event.type == sf::Event::Closed)
-                win.close();
+        bool rollScreen = screen == Screen::VIEW_DETAILS_ROLL ||
+                          screen == Screen::VIEW_ATT_ROLL ||
+                          screen == Screen::PIE_ROLL;
+        if (rollScreen && event.key.code == sf::Keyboard::Up && searchSel > 0)
+            searchSel--;
+        if (rollScreen && event.key.code == sf::Keyboard::Down &&
+            searchSel + 1 < (int)search.hits().size())
+            searchSel++;
+
+        if (screen == Screen::MENU && event.key.control) {
+            if (event.key.code == sf::Keyboard::Z) roster.undo();
+            if (event.key.code == sf::Keyboard::Y) roster.redo();
+        }
 
-            if (event.type == sf::Event::Resized) {
-                view.setSize(event.size.width, event.size.height);
-                view.setCenter(event.size.width/2.f, event.size.height/2.f);
-                win.setView(view);
-            }
+        if (screen == Screen::MSG &&
+            event.key.code == sf::Keyboard::Enter)
+        {
+            screen = Screen::MENU;
+            input.clear();
+            msgTitle.clear();
+            msgText.clear();
+        }
+    }
 
-            if (event.type == sf::Event::KeyPressed) {
-                if (event.key.code == sf::Keyboard::Enter)
-                    enterPressed = true;
+    if (typing() &&
+        event.type == sf::Event::TextEntered &&
+        screen != Screen::MSG)
+    {
+        char32_t c = event.text.unicode;
+        if (c == 8) { // backspace
+            if (!input.empty()) input.pop_back();
+            searchSel = 0;
+        } else if (c == 13) {
+            // ignore: handled by KeyPressed
+        } else if (c >= 32 && c < 127) {
+            input.push_back((char)c);
+            searchSel = 0;
+        }
+    }
+}
 
-                if (event.key.code == sf::Keyboard::Escape &&
-                    screen != Screen::SUBJECT_COUNT &&
-                    screen != Screen::SUBJECT_NAME &&
-                    screen != Screen::MSG)
-                {
-                    screen = Screen::MENU;
-                    input.clear();
-                }
+void App::update() {
+    // SUBJECT SETUP FLOW
+    if (screen == Screen::SUBJECT_COUNT && enterPressed) {
+        try {
+            subjectCount = stoi(input);
+            if (subjectCount < 1) subjectCount = 1;
+            subjectNames.clear();
+            subjectNames.resize(subjectCount);
+            subjectIndex = 0;
+            input.clear();
+            screen = Screen::SUBJECT_NAME;
+        } catch (...) {
+            input.clear();
+        }
+    }
+
+    if (screen == Screen::SUBJECT_NAME && enterPressed) {
+        if (!input.empty()) {
+            subjectNames[subjectIndex] = input;
+            input.clear();
+            subjectIndex++;
+            if (subjectIndex >= subjectCount) {
+                screen = Screen::MENU;
+            }
+        }
+    }
 
-                if (screen == Screen::MSG &&
-                    event.key.code == sf::Keyboard::Enter)
-                {
-                    screen = Screen::MENU;
+    // ADD BASIC STUDENT FLOW
+    if (screen == Screen::ADD_BASIC && enterPressed && !input.empty()) {
+        try {
+            switch (addStep) {
+                case AddStep::ROLL:
+                    tempRoll = stoi(input);
+                    tempStudent = Student();
                     input.clear();
-                    msgTitle.clear();
-                    msgText.clear();
-                }
+                    addStep = AddStep::NAME;
+                    break;
+                case AddStep::NAME:
+                    tempStudent.name = input;
+                    input.clear();
+                    addStep = AddStep::DOB;
+                    break;
+                case AddStep::DOB:
+                    tempStudent.dob = input;
+                    input.clear();
+                    addStep = AddStep::ADDRESS;
+                    break;
+                case AddStep::ADDRESS:
+                    tempStudent.address = input;
+                    input.clear();
+                    addStep = AddStep::YEAR;
+                    break;
+                case AddStep::YEAR:
+                    tempStudent.year = input;
+                    input.clear();
+                    addStep = AddStep::CGPA;
+                    break;
+                case AddStep::CGPA:
+                    tempStudent.cgpa = stof(input);
+                    input.clear();
+                    // now go to per-subject attendance
+                    tempStudent.subjects.clear();
+                    tempStudent.subjects.resize(subjectNames.size());
+                    for (size_t i=0;i<subjectNames.size();++i)
+                        tempStudent.subjects[i].name = subjectNames[i];
+                    attendSubIndex = 0;
+                    attendStep = AttendStep::TOTAL;
+                    screen = Screen::ADD_ATTEND;
+                    break;
             }
+        } catch (...) {
+            input.clear();
+        }
+    }
 
-            if (activeInput &&
-                event.type == sf::Event::TextEntered &&
-                screen != Screen::MSG)
-            {
-                char32_t c = event.text.unicode;
-                if (c == 8) { // backspace
-                    if (!activeInput->empty()) activeInput->pop_back();
-                } else if (c == 13) {
-                    // ignore: handled by KeyPressed
-                } else if (c >= 32 && c < 127) {
-                    activeInput->push_back((char)c);
+    // ADD ATTENDANCE FLOW
+    if (screen == Screen::ADD_ATTEND && enterPressed && !input.empty()) {
+        try {
+            SubjectInfo &sub = tempStudent.subjects[attendSubIndex];
+            if (attendStep == AttendStep::TOTAL) {
+                sub.total = stoi(input);
+                input.clear();
+                attendStep = AttendStep::PRESENT;
+            } else {
+                sub.present = stoi(input);
+                input.clear();
+                attendSubIndex++;
+                if (attendSubIndex >= (int)tempStudent.subjects.size()) {
+                    // done, save student
+                    bool existed = roster.current().contains(tempRoll);
+                    size_t before = roster.version();
+                    roster.commit(roster.current().with(tempRoll, tempStudent));
+                    if (existed) {
+                        msgTitle = "Student Updated";
+                        msgText  = "Previous details kept in version " +
+                                   to_string(before) + " (Ctrl+Z undoes).";
+                    } else {
+                        msgTitle = "Student Saved";
+                        msgText  = "Student details and subject attendance stored.";
+                    }
+                    screen   = Screen::MSG;
+                    addStep  = AddStep::ROLL;
+                } else {
+                    attendStep = AttendStep::TOTAL;
                 }
             }
+        } catch (...) {
+            input.clear();
         }
+    }
 
-        // ========== LOGIC (after events) ==========
+    // VIEW DETAILS / ATT / PIE lookup (fuzzy search, picks the highlighted hit)
+    auto handleRollEnter = [&](Screen from, Screen to) {
+        if (screen != from) return;
+        const vector<SearchHit> &hits = search.update(roster.current(), input);
+        if (searchSel >= (int)hits.size()) searchSel = 0;
+        if (enterPressed && !input.empty()) {
+            input.clear();
+            if (hits.empty()) {
+                msgTitle = "Not Found";
+                msgText  = "No student matches that roll or name.";
+                screen   = Screen::MSG;
+            } else {
+                currentRoll = hits[searchSel].roll;
+                screen = to;
+            }
+            searchSel = 0;
+        }
+    };
+
+    handleRollEnter(Screen::VIEW_DETAILS_ROLL, Screen::VIEW_DETAILS_SHOW);
+    handleRollEnter(Screen::VIEW_ATT_ROLL,     Screen::VIEW_ATT_SHOW);
+    handleRollEnter(Screen::PIE_ROLL,          Screen::PIE_SHOW);
+
+    // ROSTER VERSION jump
+    if (screen == Screen::VERSION_PICK && enterPressed && !input.empty()) {
+        try {
+            int v = stoi(input);
+            input.clear();
+            if (v < 0 || !roster.jumpTo((size_t)v)) {
+                msgTitle = "No Such Version";
+                msgText  = "Versions run from 0 to " + to_string(roster.latest()) + ".";
+            } else {
+                msgTitle = "Roster Version " + to_string(v);
+                msgText  = "Saving now adds version " + to_string(roster.latest() + 1) +
+                           "; no version is ever discarded.";
+            }
+            screen = Screen::MSG;
+        } catch (...) {
+            input.clear();
+        }
+    }
 
-        // SUBJECT SETUP FLOW
-        if (screen == Screen::SUBJECT_COUNT && enterPressed) {
-            try {
-                subjectCount = stoi(input);
-                if (subjectCount < 1) subjectCount = 1;
-                subjectNames.clear();
-                subjectNames.resize(subjectCount);
-                subjectIndex = 0;
+    enterPressed = false;
+}
+
+void App::draw(sf::RenderTarget &win) {
+    win.clear(sf::Color(235, 215, 255)); // bright lavender background
+
+    // Title near top (Layout A)
+    drawCenteredText(win, "STUDENT ATTENDANCE PORTAL",
+                     50.f, 34, sf::Color(90, 0, 160));
+
+    switch (screen) {
+        case Screen::SUBJECT_COUNT:
+            drawInputCard(win,
+                "Initial Setup",
+                "How many subjects do you want to track?",
+                input);
+            break;
+
+        case Screen::SUBJECT_NAME: {
+            string prompt = "Enter name for Subject " +
+                            to_string(subjectIndex+1) + " of " +
+                            to_string(subjectCount) + ":";
+            drawInputCard(win,
+                "Initial Setup - Subject Names",
+                prompt,
+                input);
+            break;
+        }
+
+        case Screen::MENU: {
+            float H = win.getSize().y;
+            float baseY = H/2.f - 155.f;
+
+            drawCardCentered(win, min(700.f, win.getSize().x*0.9f), 410.f);
+            drawCenteredText(win,
+                "Choose an option (ESC inside screens returns here)",
+                baseY-60.f, 18, sf::Color(80,60,130));
+
+            if (drawButtonCentered(win, "Add New Student", baseY, pointer)) {
+                screen = Screen::ADD_BASIC;
+                addStep = AddStep::ROLL;
                 input.clear();
-                screen = Screen::SUBJECT_NAME;
-            } catch (...) {
+            }
+            if (drawButtonCentered(win, "View Student Details", baseY+70.f, pointer)) {
+                screen = Screen::VIEW_DETAILS_ROLL;
+                input.clear();
+            }
+            if (drawButtonCentered(win, "View Attendance Summary", baseY+140.f, pointer)) {
+                screen = Screen::VIEW_ATT_ROLL;
+                input.clear();
+            }
+            if (drawButtonCentered(win, "View Attendance Pie Chart", baseY+210.f, pointer)) {
+                screen = Screen::PIE_ROLL;
+                input.clear();
+            }
+            if (drawButtonCentered(win, "Go To Roster Version", baseY+280.f, pointer)) {
+                screen = Screen::VERSION_PICK;
                 input.clear();
             }
+            drawCenteredText(win,
+                rosterLoading ? string("Loading saved roster...") :
+                "Roster version " + to_string(roster.version()) + " of " +
+                to_string(roster.latest()) + "   (Ctrl+Z undo, Ctrl+Y redo)",
+                baseY+335.f, 18, sf::Color(80,60,130));
+            break;
         }
 
-        if (screen == Screen::SUBJECT_NAME && enterPressed) {
-            if (!input.empty()) {
-                subjectNames[subjectIndex] = input;
-                input.clear();
-                subjectIndex++;
-                if (subjectIndex >= subjectCount) {
-                    screen = Screen::MENU;
-                }
+        case Screen::MSG:
+            drawMessageCard(win, msgTitle, msgText);
+            break;
+
+        case Screen::ADD_BASIC: {
+            string prompt;
+            switch (addStep) {
+                case AddStep::ROLL:    prompt="Enter Admission / Roll Number:"; break;
+                case AddStep::NAME:    prompt="Enter Full Name of Student:"; break;
+                case AddStep::DOB:     prompt="Enter Date of Birth (YYYY-MM-DD):"; break;
+                case AddStep::ADDRESS: prompt="Enter Address:"; break;
+                case AddStep::YEAR:    prompt="Enter Year (e.g. 2nd Year):"; break;
+                case AddStep::CGPA:    prompt="Enter CGPA:"; break;
             }
+            drawInputCard(win,
+                "Add New Student - Details",
+                prompt,
+                input);
+            break;
         }
 
-        // ADD BASIC STUDENT FLOW
-        if (screen == Screen::ADD_BASIC && enterPressed && !input.empty()) {
-            try {
-                switch (addStep) {
-                    case AddStep::ROLL:
-                        tempRoll = stoi(input);
-                        tempStudent = Student();
-                        input.clear();
-                        addStep = AddStep::NAME;
-                        break;
-                    case AddStep::NAME:
-                        tempStudent.name = input;
-                        input.clear();
-                        addStep = AddStep::DOB;
-                        break;
-                    case AddStep::DOB:
-                        tempStudent.dob = input;
-                        input.clear();
-                        addStep = AddStep::ADDRESS;
-                        break;
-                    case AddStep::ADDRESS:
-                        tempStudent.address = input;
-                        input.clear();
-                        addStep = AddStep::YEAR;
-                        break;
-                    case AddStep::YEAR:
-                        tempStudent.year = input;
-                        input.clear();
-                        addStep = AddStep::CGPA;
-                        break;
-                    case AddStep::CGPA:
-                        tempStudent.cgpa = stof(input);
-                        input.clear();
-                        // now go to per-subject attendance
-                        tempStudent.subjects.clear();
-                        tempStudent.subjects.resize(subjectNames.size());
-                        for (size_t i=0;i<subjectNames.size();++i)
-                            tempStudent.subjects[i].name = subjectNames[i];
-                        attendSubIndex = 0;
-                        attendStep = AttendStep::TOTAL;
-                        screen = Screen::ADD_ATTEND;
-                        break;
-                }
-            } catch (...) {
-                input.clear();
+        case Screen::ADD_ATTEND: {
+            float cardW = min(700.f, win.getSize().x*0.9f);
+            float cardH = 320.f;
+            drawCardCentered(win, cardW, cardH);
+            float H = win.getSize().y;
+            float top = (H-cardH)/2.f;
+
+            SubjectInfo &sub = tempStudent.subjects[attendSubIndex];
+            string title = "Attendance for Subject " +
+                           to_string(attendSubIndex+1) + " of " +
+                           to_string(tempStudent.subjects.size());
+            drawCenteredText(win, title, top+30.f, 24, sf::Color(60,0,110));
+            drawCenteredText(win, "Subject : " + sub.name, top+70.f, 22, sf::Color(40,0,80));
+
+            string prompt;
+            if (attendStep == AttendStep::TOTAL)
+                prompt = "Enter TOTAL classes conducted for " + sub.name + ":";
+            else
+                prompt = "Enter PRESENT classes for " + sub.name + ":";
+
+            drawCenteredText(win, prompt, top+115.f, 20, sf::Color(40,0,90));
+            drawCenteredText(win, input,  top+160.f, 26, sf::Color(0,100,40));
+            drawCenteredText(win,
+                "Type number and press ENTER (ESC cancels and goes to menu)",
+                top+205.f, 18, sf::Color(80,60,130));
+            break;
+        }
+
+        case Screen::VIEW_DETAILS_ROLL:
+            drawSearchCard(win,
+                "View Student Details",
+                input,
+                search.hits(),
+                searchSel);
+            break;
+
+        case Screen::VIEW_DETAILS_SHOW: {
+            const Student &s = roster.current().at(currentRoll);
+
+            float cardW = min(700.f, win.getSize().x*0.9f);
+            float cardH = 400.f;
+            drawCardCentered(win, cardW, cardH);
+            float H = win.getSize().y;
+            float top = (H-cardH)/2.f;
+
+            drawCenteredText(win, "Student Profile", top+40.f, 26, sf::Color(60,0,110));
+            drawCenteredText(win, "Roll : " + to_string(currentRoll), top+85.f, 20);
+            drawCenteredText(win, "Name : " + s.name,                 top+115.f, 20);
+            drawCenteredText(win, "DOB  : " + s.dob,                  top+145.f, 20);
+            drawCenteredText(win, "Address : " + s.address,           top+175.f, 20);
+            drawCenteredText(win, "Year : " + s.year,                 top+205.f, 20);
+            drawCenteredText(win,
+                "CGPA : " + to_string(s.cgpa).substr(0,4),
+                top+235.f, 20, sf::Color(0,110,70));
+
+            drawCenteredText(win,
+                "Press ESC to return to menu",
+                top+cardH-40.f, 18, sf::Color(80,60,130));
+            break;
+        }
+
+        case Screen::VIEW_ATT_ROLL:
+            drawSearchCard(win,
+                "View Attendance Summary",
+                input,
+                search.hits(),
+                searchSel);
+            break;
+
+        case Screen::VIEW_ATT_SHOW: {
+            const Student &s = roster.current().at(currentRoll);
+
+            int totalC=0,totalP=0;
+            for (auto &sub: s.subjects) {
+                totalC += sub.total;
+                totalP += sub.present;
+            }
+            float overall = (totalC>0)?(100.f*totalP/totalC):0.f;
+
+            float cardW = min(820.f, win.getSize().x*0.95f);
+            float cardH = 520.f;
+            drawCardCentered(win, cardW, cardH);
+            float W = win.getSize().x;
+            float H = win.getSize().y;
+            float top = (H-cardH)/2.f;
+            float left = W/2.f - cardW/2.f + 40.f;
+
+            drawCenteredText(win, "Attendance Summary",
+                             top+40.f, 26, sf::Color(60,0,110));
+
+            drawCenteredText(win,
+                "Roll : " + to_string(currentRoll) +
+                "   Name : " + s.name,
+                top+80.f, 20);
+
+            drawCenteredText(win,
+                "Overall Attendance : " +
+                to_string(overall).substr(0,5) + "%",
+                top+115.f, 22, sf::Color(0,120,70));
+
+            // Table header (ATT2 style)
+            float y = top + 160.f;
+            drawLeftText(win, "Subject",      left,       y, 20, sf::Color(40,0,80));
+            drawLeftText(win, "Total",        left+260.f, y, 20, sf::Color(40,0,80));
+            drawLeftText(win, "Present",      left+340.f, y, 20, sf::Color(40,0,80));
+            drawLeftText(win, "Percent",      left+440.f, y, 20, sf::Color(40,0,80));
+            y += 8.f;
+
+            // simple horizontal line
+            sf::RectangleShape line(sf::Vector2f(cardW-80.f, 2.f));
+            line.setPosition(left, y+14.f);
+            line.setFillColor(sf::Color(160,140,220));
+            win.draw(line);
+            y += 30.f;
+
+            for (auto &sub : s.subjects) {
+                float per = (sub.total>0)?(100.f*sub.present/sub.total):0.f;
+                drawLeftText(win, sub.name,                  left,       y, 18);
+                drawLeftText(win, to_string(sub.total),      left+260.f, y, 18);
+                drawLeftText(win, to_string(sub.present),    left+340.f, y, 18);
+                drawLeftText(win, to_string(per).substr(0,5)+"%", left+440.f, y, 18);
+                y += 26.f;
             }
+
+            drawCenteredText(win,
+                "Press ESC to return to menu",
+                top+cardH-40.f, 18, sf::Color(80,60,130));
+            break;
         }
 
-        // ADD ATTENDANCE FLOW
-        if (screen == Screen::ADD_ATTEND && enterPressed && !input.empty()) {
-            try {
-                SubjectInfo &sub = tempStudent.subjects[attendSubIndex];
-                if (attendStep == AttendStep::TOTAL) {
-                    sub.total = stoi(input);
-                    input.clear();
-                    attendStep = AttendStep::PRESENT;
-                } else {
-                    sub.present = stoi(input);
-                    input.clear();
-                    attendSubIndex++;
-                    if (attendSubIndex >= (int)tempStudent.subjects.size()) {
-                        // done, save student
-                        DB[tempRoll] = tempStudent;
-                        msgTitle = "Student Saved";
-                        msgText  = "Student details and subject attendance stored.";
-                        screen   = Screen::MSG;
-                        addStep  = AddStep::ROLL;
-                    } else {
-                        attendStep = AttendStep::TOTAL;
-                    }
-                }
-            } catch (...) {
-                input.clear();
+        case Screen::PIE_ROLL:
+            drawSearchCard(win,
+                "Attendance Pie Chart",
+                input,
+                search.hits(),
+                searchSel);
+            break;
+
+        case Screen::VERSION_PICK:
+            drawInputCard(win,
+                "Go To Roster Version",
+                "Enter version (0 - " + to_string(roster.latest()) + "):",
+                input);
+            break;
+
+        case Screen::PIE_SHOW:
+            drawPieCard(win, currentRoll, roster.current().at(currentRoll),
+                        "Press ESC to return to menu");
+            break;
+    }
+
+    pointer.clicked = false;
+}
+
+// ============== BENCHMARKS ========================
+
+double peakMemoryMiB() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#ifdef __APPLE__
+    return ru.ru_maxrss / (1024.0 * 1024.0);   // bytes on macOS
+#else
+    return ru.ru_maxrss / 1024.0;              // kilobytes on Linux
+#endif
+}
+
+// Heap bytes behind one saved Student: its make_shared block plus any
+// strings too long for the small-string buffer and the subject list.
+size_t studentBytes(const Student &s) {
+    auto heap = [](const string &x) {
+        const char *p = x.data();
+        bool inside = p >= (const char*)&x && p < (const char*)(&x + 1);
+        return inside ? (size_t)0 : x.capacity() + 1;
+    };
+    size_t bytes = sizeof(Student) + 16 + heap(s.name) + heap(s.dob) +
+                   heap(s.address) + heap(s.year) +
+                   s.subjects.capacity() * sizeof(SubjectInfo);
+    for (auto &sub : s.subjects) bytes += heap(sub.name);
+    return bytes;
+}
+
+// --bench-versions N : N sequential saves (half new rolls, half overwrites),
+// then how long undo/redo/jumps take and how much the history really holds.
+int benchVersions(int edits) {
+    typedef chrono::steady_clock Clock;
+    auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    RosterHistory h;
+    int rolls = max(1, edits / 2);
+    Student s;
+    s.name = "Bench Student";
+    s.address = "Flat 4, Hostel Block C, University Campus";
+    for (const char *name : {"Maths", "Physics", "Chemistry", "English", "Computer Science"}) {
+        SubjectInfo sub;
+        sub.name = name;
+        s.subjects.push_back(sub);
+    }
+
+    size_t fullCopyNodes = 0;   // what copying the whole roster per save would keep
+    auto t0 = Clock::now();
+    for (int i = 0; i < edits; ++i) {
+        int roll = 1 + (int)((long long)i * 7919 % rolls);
+        s.cgpa = (float)(i % 10);
+        h.commit(h.current().with(roll, s));
+        fullCopyNodes += h.current().size();
+    }
+    auto t1 = Clock::now();
+    size_t students = h.current().size();
+
+    while (h.undo()) {}
+    auto t2 = Clock::now();
+    while (h.redo()) {}
+    auto t3 = Clock::now();
+
+    size_t found = 0;
+    for (int i = 0; i < edits; ++i) {
+        h.jumpTo((size_t)((long long)i * 4099 % (h.latest() + 1)));
+        found += h.current().contains(1 + i % rolls);
+    }
+    auto t4 = Clock::now();
+
+    size_t nodeBytes = Roster::nodeBytes() + 16;   // + shared_ptr control block
+    size_t live = Roster::liveNodes();
+    size_t oneStudent = studentBytes(s);           // every save keeps its own copy
+    size_t held = live * nodeBytes + (size_t)edits * oneStudent;
+    size_t fullCopies = fullCopyNodes * (nodeBytes + oneStudent);
+    cout << "edits            : " << edits << "\n"
+         << "versions kept    : " << h.latest() + 1 << "\n"
+         << "students (latest): " << students << "\n"
+         << "tree nodes live  : " << live << "  ("
+         << (double)live / max(1, edits) << " per edit)\n"
+         << "history memory   : " << held / 1024 << " KiB  (nodes "
+         << live * nodeBytes / 1024 << " + students " << (size_t)edits * oneStudent / 1024
+         << "; full copies: " << fullCopies / 1024 << " KiB)\n"
+         << "peak RSS         : " << peakMemoryMiB() << " MiB\n"
+         << "commit           : " << ms(t1 - t0) * 1000.0 / max(1, edits) << " us avg\n"
+         << "undo to v0       : " << ms(t2 - t1) << " ms\n"
+         << "redo to latest   : " << ms(t3 - t2) << " ms\n"
+         << "jump + lookup    : " << ms(t4 - t3) * 1000.0 / max(1, edits) << " us avg ("
+         << found << " hits)\n";
+    return 0;
+}
+
+// --synthetic N : fill the roster with N generated students in one version,
+// so search, replays and chart rendering can be tried at scale.
+// Made-up surname that is different for every i, e.g. "Bakomu", so the
+// synthetic roster has no two students with the same name.
+string syntheticSurname(int i) {
+    static const char cons[]  = "bdfghklmnprstvz";
+    static const char vowel[] = "aeiou";
+    string s;
+    for (int k = 0; k < 3 || i > 0; ++k, i /= 75) {
+        s += cons[i % 15];
+        s += vowel[i / 15 % 5];
+    }
+    s[0] = (char)toupper((unsigned char)s[0]);
+    return s;
+}
+
+void fillSyntheticRoster(int n, int rollStep = 1) {
+    static const char *first[] = {"Aarav", "Diya", "Kiran", "Meera", "Rohan",
+                                  "Sneha", "Vikram", "Ananya", "Arjun", "Priya"};
+    if (subjectNames.empty())
+        subjectNames = {"Maths", "Physics", "Chemistry", "English", "Computer Science"};
+
+    mt19937 rng(42);
+    Roster r = roster.current();
+    for (int i = 0; i < n; ++i) {
+        Student s;
+        s.name    = string(first[rng() % 10]) + " " + syntheticSurname(i);
+        s.dob     = to_string(2000 + rng() % 6) + "-0" + to_string(1 + rng() % 9) + "-1" + to_string(rng() % 10);
+        s.address = "Hyderabad";
+        s.year    = to_string(1 + rng() % 4) + " Year";
+        s.cgpa    = 5.f + (rng() % 500) / 100.f;
+        for (auto &name : subjectNames) {
+            SubjectInfo sub;
+            sub.name    = name;
+            sub.total   = 30 + rng() % 20;
+            sub.present = rng() % (sub.total + 1);
+            s.subjects.push_back(sub);
+        }
+        r = r.with(1000 + i * rollStep, s);
+    }
+    roster.commit(r);
+}
+
+// --bench-search N : per-keystroke search latency over N synthetic students.
+// Types rolls and names that contain one typo (first character included),
+// one character at a time, the way the lookup screens call update(). Rolls
+// are spaced out so a mistyped roll usually isn't another student's.
+int benchSearch(int n) {
+    typedef chrono::steady_clock Clock;
+    auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    fillSyntheticRoster(n, 7);
+    const Roster &r = roster.current();
+    vector<pair<int, string>> students;
+    r.forEach([&](int roll, const Student &s) { students.push_back({roll, s.name}); });
+
+    StudentSearch search;
+    auto t0 = Clock::now();
+    search.update(r, "");
+    double buildMs = ms(Clock::now() - t0);
+
+    mt19937 rng(7);
+    vector<double> all, first, second;
+    int found[2] = {0, 0}, asked[2] = {0, 0};   // [by name, by roll]
+    for (int q = 0; q < 200; ++q) {
+        auto &target = students[rng() % students.size()];
+        bool byRoll = q % 2 == 0;
+        string text = byRoll ? to_string(target.first) : target.second;
+        for (char &c : text) c = (char)tolower((unsigned char)c);
+
+        size_t pos = rng() % text.size();   // one substitution typo
+        if (isdigit((unsigned char)text[pos]))      text[pos] = (char)('0' + (text[pos] - '0' + 1) % 10);
+        else if (isalpha((unsigned char)text[pos])) text[pos] = (char)('a' + (text[pos] - 'a' + 1) % 26);
+
+        for (size_t i = 1; i <= text.size(); ++i) {
+            auto a = Clock::now();
+            search.update(r, text.substr(0, i));
+            double t = ms(Clock::now() - a);
+            all.push_back(t);
+            if (i == 1) first.push_back(t);
+            if (i == 2) second.push_back(t);
+        }
+        asked[byRoll]++;
+        for (auto &h : search.hits()) found[byRoll] += h.roll == target.first;
+        search.update(r, "");
+    }
+
+    auto report = [](vector<double> v) {
+        sort(v.begin(), v.end());
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        ostringstream out;
+        out << fixed << setprecision(3) << "avg " << (v.empty() ? 0.0 : sum / v.size())
+            << "  p95 " << (v.empty() ? 0.0 : v[min(v.size() - 1, (size_t)(0.95 * v.size()))])
+            << "  max " << (v.empty() ? 0.0 : v.back()) << " ms";
+        return out.str();
+    };
+    cout << fixed << setprecision(3)
+         << "students         : " << students.size() << "\n"
+         << "index build      : " << buildMs << " ms\n"
+         << "keystrokes       : " << all.size() << "  " << report(all) << "\n"
+         << "  1st char       : " << report(first) << "\n"
+         << "  2nd char       : " << report(second) << "\n"
+         << "mistyped rolls   : " << found[1] << " of " << asked[1] << " in the shown hits\n"
+         << "mistyped names   : " << found[0] << " of " << asked[0] << " in the shown hits\n";
+    return 0;
+}
+
+// ============== REPLAY ==========================
+
+// Recorded input, one frame per line:
+//   text <chars>   type the characters        enter / escape / backspace
+//   up / down      move the search selection  ctrl+z / ctrl+y (undo / redo)
+//   click X Y      left click at X,Y          frame [N]  N frames with no input
+//   resize W H     window resized to W x H (the layout follows the size)
+//   expect screen S | students N | version N
+//                  check the state so far; --replay fails if it differs
+// A line starting with + adds its input to the frame above instead of
+// starting a new one. Blank lines and lines starting with # are skipped.
+
+sf::Event keyEvent(sf::Keyboard::Key code, bool control = false) {
+    sf::Event e = sf::Event();
+    e.type = sf::Event::KeyPressed;
+    e.key.code = code;
+    e.key.control = control;
+    return e;
+}
+
+sf::Event textEvent(sf::Uint32 c) {
+    sf::Event e = sf::Event();
+    e.type = sf::Event::TextEntered;
+    e.text.unicode = c;
+    return e;
+}
+
+// Turn one replay line into the events of a frame. frames is how many
+// frames the line covers (0 for comments). Returns false if unreadable.
+bool parseReplayLine(string line, vector<sf::Event> &out, int &frames) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    out.clear();
+    frames = 1;
+
+    if (line.empty() || line[0] == '#') { frames = 0; return true; }
+
+    if (line.rfind("text ", 0) == 0) {
+        for (size_t i = 5; i < line.size(); ++i)
+            out.push_back(textEvent((unsigned char)line[i]));
+        return true;
+    }
+
+    istringstream ss(line);
+    string cmd;
+    ss >> cmd;
+    if      (cmd == "enter")     { out.push_back(keyEvent(sf::Keyboard::Enter)); out.push_back(textEvent(13)); }
+    else if (cmd == "escape")    out.push_back(keyEvent(sf::Keyboard::Escape));
+    else if (cmd == "backspace") { out.push_back(keyEvent(sf::Keyboard::Backspace)); out.push_back(textEvent(8)); }
+    else if (cmd == "up")        out.push_back(keyEvent(sf::Keyboard::Up));
+    else if (cmd == "down")      out.push_back(keyEvent(sf::Keyboard::Down));
+    else if (cmd == "ctrl+z")    out.push_back(keyEvent(sf::Keyboard::Z, true));
+    else if (cmd == "ctrl+y")    out.push_back(keyEvent(sf::Keyboard::Y, true));
+    else if (cmd == "click") {
+        int x, y;
+        if (!(ss >> x >> y)) return false;
+        sf::Event e = sf::Event();
+        e.type = sf::Event::MouseButtonPressed;
+        e.mouseButton.button = sf::Mouse::Left;
+        e.mouseButton.x = x;
+        e.mouseButton.y = y;
+        out.push_back(e);
+    }
+    else if (cmd == "resize") {
+        unsigned w, h;
+        if (!(ss >> w >> h) || w == 0 || h == 0) return false;
+        sf::Event e = sf::Event();
+        e.type = sf::Event::Resized;
+        e.size.width = w;
+        e.size.height = h;
+        out.push_back(e);
+    }
+    else if (cmd == "frame") {
+        if (!(ss >> frames)) frames = 1;
+    }
+    else return false;
+    return true;
+}
+
+// Replay line for a live event, or "" for events a replay doesn't need.
+string replayLine(const sf::Event &e) {
+    if (e.type == sf::Event::TextEntered) {
+        sf::Uint32 c = e.text.unicode;
+        if (c >= 32 && c < 127) return "text " + string(1, (char)c);
+        return "";
+    }
+    if (e.type == sf::Event::KeyPressed) {
+        switch (e.key.code) {
+            case sf::Keyboard::Enter:     return "enter";
+            case sf::Keyboard::Escape:    return "escape";
+            case sf::Keyboard::Backspace: return "backspace";
+            case sf::Keyboard::Up:        return "up";
+            case sf::Keyboard::Down:      return "down";
+            case sf::Keyboard::Z:         return e.key.control ? "ctrl+z" : "";
+            case sf::Keyboard::Y:         return e.key.control ? "ctrl+y" : "";
+            default:                      return "";
+        }
+    }
+    if (e.type == sf::Event::MouseButtonPressed && e.mouseButton.button == sf::Mouse::Left)
+        return "click " + to_string(e.mouseButton.x) + " " + to_string(e.mouseButton.y);
+    if (e.type == sf::Event::Resized)
+        return "resize " + to_string(e.size.width) + " " + to_string(e.size.height);
+    return "";
+}
+
+// Writes live input in the format above: a frame's events go on one line
+// plus "+" lines, and runs of idle frames become a single "frame N".
+class ReplayRecorder {
+public:
+    ~ReplayRecorder() { flushIdle(); }
+
+    bool open(const string &path) { out.open(path); return (bool)out; }
+    void add(const sf::Event &e) {
+        if (!out.is_open()) return;
+        string line = replayLine(e);
+        if (line.empty()) return;
+        bool text = line.rfind("text ", 0) == 0;
+        if (text && !lines.empty() && lines.back().rfind("text ", 0) == 0)
+            lines.back() += line.substr(5);
+        else
+            lines.push_back(line);
+    }
+
+    void endFrame() {
+        if (!out.is_open()) return;
+        if (lines.empty()) { idle++; return; }
+        flushIdle();
+        for (size_t i = 0; i < lines.size(); ++i)
+            out << (i ? "+" : "") << lines[i] << "\n";
+        lines.clear();
+    }
+
+private:
+    void flushIdle() {
+        if (idle > 0) out << "frame " << idle << "\n";
+        idle = 0;
+    }
+
+    ofstream out;
+    vector<string> lines;   // this frame's input so far
+    int idle = 0;           // idle frames not written yet
+};
+
+// --replay FILE : run a recording through the same App against an
+// offscreen target as fast as possible and report where the time went.
+int runReplay(const string &path) {
+    typedef chrono::steady_clock Clock;
+    auto ms = [](Clock::duration d) { return chrono::duration<double, milli>(d).count(); };
+
+    ifstream in(path);
+    if (!in) {
+        cerr << "Cannot open replay file " << path << "\n";
+        return 1;
+    }
+
+    // A frame's input, played repeat times. repeat 0 is an expect line,
+    // checked between frames instead.
+    struct ReplayFrame {
+        vector<sf::Event> events;
+        int    repeat = 1;
+        int    lineNo = 0;
+        string expect, want;
+    };
+    vector<ReplayFrame> script;
+
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.rfind("expect ", 0) == 0) {
+            ReplayFrame check;
+            check.repeat = 0;
+            check.lineNo = lineNo;
+            istringstream ss(line.substr(7));
+            bool ok = (bool)(ss >> check.expect >> check.want);
+            if (ok && check.expect == "screen") {
+                ok = false;
+                for (int s = 0; s <= (int)Screen::VERSION_PICK; ++s)
+                    ok = ok || check.want == screenName((Screen)s);
+            } else if (ok) {
+                ok = (check.expect == "students" || check.expect == "version") &&
+                     check.want.find_first_not_of("0123456789") == string::npos;
+            }
+            if (!ok) {
+                cerr << path << ":" << lineNo << ": cannot read \"" << line << "\"\n";
+                return 1;
             }
+            script.push_back(check);
+            continue;
         }
+        bool extra = !line.empty() && line[0] == '+';
+        vector<sf::Event> events;
+        int frames = 0;
+        bool ok = parseReplayLine(extra ? line.substr(1) : line, events, frames);
+        if (ok && extra)
+            ok = frames == 1 && !events.empty() &&
+                 !script.empty() && !script.back().events.empty();
+        if (!ok) {
+            cerr << path << ":" << lineNo << ": cannot read \"" << line << "\"\n";
+            return 1;
+        }
+        if (frames == 0) continue;
+        if (extra)
+            script.back().events.insert(script.back().events.end(), events.begin(), events.end());
+        else
+            script.push_back({events, frames, lineNo, "", ""});
+    }
 
-        // VIEW DETAILS / ATT ROLL input
-        auto handleRollEnter = [&](Screen from, Screen to) {
-            if (screen == from && enterPressed && !input.empty()) {
-                try {
-                    currentRoll = stoi(input);
-                    input.clear();
-                    if (!DB.count(currentRoll)) {
-                        msgTitle = "Not Found";
-                        msgText  = "No student exists with that roll.";
-                        screen   = Screen::MSG;
-                    } else {
-                        screen = to;
+    sf::RenderTexture target;
+    if (!target.create(1000, 700)) {
+        cerr << "Cannot create offscreen render target (needs an OpenGL context;"
+                " on a headless machine run under xvfb-run)\n";
+        return 1;
+    }
+
+    struct Timing {
+        int    count = 0;
+        double total = 0.0;
+        double worst = 0.0;
+    };
+
+    App app;
+    if (!subjectNames.empty()) app.screen = Screen::MENU;
+    vector<double> frameMs;
+    double logicMs = 0.0, drawMs = 0.0;
+    map<string, Timing> transitions;
+
+    int passed = 0, failed = 0;
+    auto start = Clock::now();
+
+    for (auto &step : script) {
+        if (step.repeat == 0) {
+            string got = step.expect == "screen"   ? string(screenName(app.screen)) :
+                         step.expect == "students" ? to_string(roster.current().size()) :
+                                                     to_string(roster.version());
+            if (got == step.want) {
+                passed++;
+            } else {
+                failed++;
+                cerr << path << ":" << step.lineNo << ": expected " << step.expect << " "
+                     << step.want << ", got " << got << "\n";
+            }
+            continue;
+        }
+        for (int f = 0; f < step.repeat; ++f) {
+            Screen before = app.screen;
+
+            auto t0 = Clock::now();
+            if (f == 0) {
+                for (auto &e : step.events) {
+                    if (e.type == sf::Event::Resized &&
+                        !target.create(e.size.width, e.size.height)) {
+                        cerr << path << ":" << step.lineNo << ": cannot resize the render target\n";
+                        return 1;
                     }
-                } catch (...) {
-                    input.clear();
+                    app.handleEvent(e);
                 }
             }
-        };
+            app.update();
+            auto t1 = Clock::now();
+            app.draw(target);
+            target.display();
+            auto t2 = Clock::now();
+
+            double frame = ms(t2 - t0);
+            frameMs.push_back(frame);
+            logicMs += ms(t1 - t0);
+            drawMs  += ms(t2 - t1);
+
+            if (app.screen != before) {
+                Timing &t = transitions[string(screenName(before)) + " -> " + screenName(app.screen)];
+                t.count++;
+                t.total += frame;
+                t.worst = max(t.worst, frame);
+            }
+        }
+    }
+    double wall = ms(Clock::now() - start);
+
+    size_t n = frameMs.size();
+    vector<double> sorted = frameMs;
+    sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return n ? sorted[min(n - 1, (size_t)(p * n))] : 0.0; };
+
+    cout << fixed << setprecision(3)
+         << "replay           : " << path << " (" << lineNo << " lines)\n"
+         << "frames           : " << n << " in " << wall << " ms ("
+         << (wall > 0 ? n * 1000.0 / wall : 0.0) << " fps)\n"
+         << "frame time       : avg " << (n ? (logicMs + drawMs) / n : 0.0)
+         << "  p50 " << pct(0.50) << "  p95 " << pct(0.95)
+         << "  max " << (n ? sorted.back() : 0.0) << " ms\n"
+         << "  logic / draw   : avg " << (n ? logicMs / n : 0.0) << " / "
+         << (n ? drawMs / n : 0.0) << " ms\n"
+         << "transitions      :\n";
+    for (auto &kv : transitions)
+        cout << "  " << left << setw(38) << kv.first << right
+             << setw(5) << kv.second.count << "x  avg "
+             << kv.second.total / kv.second.count << "  max "
+             << kv.second.worst << " ms\n";
+    cout << "final screen     : " << screenName(app.screen)
+         << ", roster version " << roster.version() << " of " << roster.latest()
+         << ", " << roster.current().size() << " students\n";
+    if (passed + failed > 0)
+        cout << "checks           : " << passed << " passed, " << failed << " failed\n";
+    return failed ? 1 : 0;
+}
 
-        handleRollEnter(Screen::VIEW_DETAILS_ROLL, Screen::VIEW_DETAILS_SHOW);
-        handleRollEnter(Screen::VIEW_ATT_ROLL,     Screen::VIEW_ATT_SHOW);
-        handleRollEnter(Screen::PIE_ROLL,          Screen::PIE_SHOW);
+// ============== CHART RENDERING ==================
 
-        // ========== DRAWING ==========
+// Fixed-size hand-off between the render and encode stages, so rendering
+// can't run ahead of PNG encoding and pile up images in memory.
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : cap(capacity) {}
 
-        win.clear(sf::Color(235, 215, 255)); // bright lavender background
+    void push(T item) {
+        unique_lock<mutex> lock(m);
+        notFull.wait(lock, [&] { return q.size() < cap; });
+        q.push_back(std::move(item));
+        notEmpty.notify_one();
+    }
 
-        // Title near top (Layout A)
-        drawCenteredText(win, "STUDENT ATTENDANCE PORTAL",
-                         50.f, 34, sf::Color(90, 0, 160));
+    // Blocks for the next item; false once closed and drained.
+    bool pop(T &out) {
+        unique_lock<mutex> lock(m);
+        notEmpty.wait(lock, [&] { return !q.empty() || closed; });
+        if (q.empty()) return false;
+        out = std::move(q.front());
+        q.pop_front();
+        notFull.notify_one();
+        return true;
+    }
 
-        switch (screen) {
-            case Screen::SUBJECT_COUNT:
-                drawInputCard(win,
-                    "Initial Setup",
-                    "How many subjects do you want to track?",
-                    input);
-                break;
+    void close() {
+        lock_guard<mutex> lock(m);
+        closed = true;
+        notEmpty.notify_all();
+    }
 
-            case Screen::SUBJECT_NAME: {
-                string prompt = "Enter name for Subject " +
-                                to_string(subjectIndex+1) + " of " +
-                                to_string(subjectCount) + ":";
-                drawInputCard(win,
-                    "Initial Setup - Subject Names",
-                    prompt,
-                    input);
-                break;
-            }
+private:
+    size_t             cap;
+    deque<T>           q;
+    bool               closed = false;
+    mutex              m;
+    condition_variable notFull, notEmpty;
+};
 
-            case Screen::MENU: {
-                float H = win.getSize().y;
-                float baseY = H/2.f - 105.f;
+// --render-charts DIR : one PNG per student of the current roster version,
+// drawn with the PIE_SHOW card. Render threads each own an offscreen
+// target (and so a GL context); encode threads write the PNGs behind them.
+int renderCharts(const string &dir, int threads) {
+    typedef chrono::steady_clock Clock;
+
+    vector<pair<int, const Student*>> jobs;
+    Roster snapshot = roster.current();   // keeps the students alive
+    snapshot.forEach([&](int roll, const Student &s) { jobs.push_back({roll, &s}); });
+    if (jobs.empty()) {
+        cerr << "Roster is empty: save students in the app first, or use --roster FILE,"
+                " --synthetic N or --replay FILE\n";
+        return 1;
+    }
 
-                drawCardCentered(win, min(700.f, win.getSize().x*0.9f), 310.f);
-                drawCenteredText(win,
-                    "Choose an option (ESC inside screens returns here)",
-                    baseY-60.f, 18, sf::Color(80,60,130));
+    error_code ec;
+    filesystem::create_directories(dir, ec);
+    if (ec) {
+        cerr << "Cannot create " << dir << ": " << ec.message() << "\n";
+        return 1;
+    }
 
-                if (drawButtonCentered(win, "Add New Student", baseY)) {
-                    screen = Screen::ADD_BASIC;
-                    addStep = AddStep::ROLL;
-                    input.clear();
-                }
-                if (drawButtonCentered(win, "View Student Details", baseY+70.f)) {
-                    screen = Screen::VIEW_DETAILS_ROLL;
-                    input.clear();
-                }
-                if (drawButtonCentered(win, "View Attendance Summary", baseY+140.f)) {
-                    screen = Screen::VIEW_ATT_ROLL;
-                    input.clear();
-                }
-                if (drawButtonCentered(win, "View Attendance Pie Chart", baseY+210.f)) {
-                    screen = Screen::PIE_ROLL;
-                    input.clear();
-                }
-                break;
-            }
+    if (threads < 1) threads = max(1, (int)thread::hardware_concurrency() / 2);
 
-            case Screen::MSG:
-                drawMessageCard(win, msgTitle, msgText);
-                break;
+    struct Chart {
+        int       roll = 0;
+        sf::Image image;
+    };
+    BoundedQueue<Chart> queue(2 * threads);
+    atomic<size_t>    next{0}, written{0}, failed{0};
+    atomic<long long> renderUs{0}, encodeUs{0};
 
-            case Screen::ADD_BASIC: {
-                string prompt;
-                switch (addStep) {
-                    case AddStep::ROLL:    prompt="Enter Admission / Roll Number:"; break;
-                    case AddStep::NAME:    prompt="Enter Full Name of Student:"; break;
-                    case AddStep::DOB:     prompt="Enter Date of Birth (YYYY-MM-DD):"; break;
-                    case AddStep::ADDRESS: prompt="Enter Address:"; break;
-                    case AddStep::YEAR:    prompt="Enter Year (e.g. 2nd Year):"; break;
-                    case AddStep::CGPA:    prompt="Enter CGPA:"; break;
-                }
-                drawInputCard(win,
-                    "Add New Student - Details",
-                    prompt,
-                    input);
-                break;
-            }
+    auto us = [](Clock::time_point a, Clock::time_point b) {
+        return (long long)chrono::duration_cast<chrono::microseconds>(b - a).count();
+    };
 
-            case Screen::ADD_ATTEND: {
-                float cardW = min(700.f, win.getSize().x*0.9f);
-                float cardH = 320.f;
-                drawCardCentered(win, cardW, cardH);
-                float H = win.getSize().y;
-                float top = (H-cardH)/2.f;
-
-                SubjectInfo &sub = tempStudent.subjects[attendSubIndex];
-                string title = "Attendance for Subject " +
-                               to_string(attendSubIndex+1) + " of " +
-                               to_string(tempStudent.subjects.size());
-                drawCenteredText(win, title, top+30.f, 24, sf::Color(60,0,110));
-                drawCenteredText(win, "Subject : " + sub.name, top+70.f, 22, sf::Color(40,0,80));
-
-                string prompt;
-                if (attendStep == AttendStep::TOTAL)
-                    prompt = "Enter TOTAL classes conducted for " + sub.name + ":";
-                else
-                    prompt = "Enter PRESENT classes for " + sub.name + ":";
-
-                drawCenteredText(win, prompt, top+115.f, 20, sf::Color(40,0,90));
-                drawCenteredText(win, input,  top+160.f, 26, sf::Color(0,100,40));
-                drawCenteredText(win,
-                    "Type number and press ENTER (ESC cancels and goes to menu)",
-                    top+205.f, 18, sf::Color(80,60,130));
-                break;
+    auto start = Clock::now();
+    vector<thread> renderers, encoders;
+    for (int t = 0; t < threads; ++t) {
+        renderers.emplace_back([&] {
+            sf::RenderTexture target;
+            if (!target.create(900, 620)) {
+                cerr << "Cannot create offscreen render target (needs an OpenGL context;"
+                        " on a headless machine run under xvfb-run)\n";
+                return;
+            }
+            for (size_t i; (i = next++) < jobs.size(); ) {
+                auto t0 = Clock::now();
+                target.clear(sf::Color(235, 215, 255));
+                drawPieCard(target, jobs[i].first, *jobs[i].second, "");
+                target.display();
+                Chart c;
+                c.roll  = jobs[i].first;
+                c.image = target.getTexture().copyToImage();
+                renderUs += us(t0, Clock::now());
+                queue.push(std::move(c));
             }
+        });
+        encoders.emplace_back([&] {
+            Chart c;
+            while (queue.pop(c)) {
+                auto t0 = Clock::now();
+                if (c.image.saveToFile(dir + "/" + to_string(c.roll) + ".png")) written++;
+                else failed++;
+                encodeUs += us(t0, Clock::now());
+            }
+        });
+    }
+    for (auto &t : renderers) t.join();
+    queue.close();
+    for (auto &t : encoders) t.join();
+    double secs = chrono::duration<double>(Clock::now() - start).count();
+
+    size_t done = written + failed;
+    cout << fixed << setprecision(2)
+         << "students         : " << jobs.size() << "\n"
+         << "images written   : " << written << " to " << dir
+         << (failed ? "  (" + to_string(failed) + " failed)" : "") << "\n"
+         << "threads          : " << threads << " render + " << threads << " encode\n"
+         << "wall time        : " << secs << " s (" << (secs > 0 ? written / secs : 0.0)
+         << " images/s)\n"
+         << "per image        : render " << (done ? renderUs / 1000.0 / done : 0.0)
+         << " ms, encode " << (done ? encodeUs / 1000.0 / done : 0.0) << " ms\n"
+         << "peak memory      : " << peakMemoryMiB() << " MiB\n";
+    return done == jobs.size() && !failed ? 0 : 1;
+}
 
-            case Screen::VIEW_DETAILS_ROLL:
-                drawInputCard(win,
-                    "View Student Details",
-                    "Enter Roll Number:",
-                    input);
-                break;
+// ============== WARM START =======================
+
+// Small text file remembering the last session, so the next start can skip
+// font discovery and subject setup:
+//   font /usr/share/fonts/truetype/dejavu/DejaVuSans.ttf
+//   roster srms_warm.txt.roster
+//   subject Maths
+//   subject Physics
+// The roster file holds one student per line, tab separated:
+//   roll name dob address year cgpa {subject total present}...
+
+struct WarmStart {
+    string fontPath;
+    string rosterPath;
+    vector<string> subjects;
+};
 
-            case Screen::VIEW_DETAILS_SHOW: {
-                const Student &s = DB[currentRoll];
-
-                float cardW = min(700.f, win.getSize().x*0.9f);
-                float cardH = 400.f;
-                drawCardCentered(win, cardW, cardH);
-                float H = win.getSize().y;
-                float top = (H-cardH)/2.f;
-
-                drawCenteredText(win, "Student Profile", top+40.f, 26, sf::Color(60,0,110));
-                drawCenteredText(win, "Roll : " + to_string(currentRoll), top+85.f, 20);
-                drawCenteredText(win, "Name : " + s.name,                 top+115.f, 20);
-                drawCenteredText(win, "DOB  : " + s.dob,                  top+145.f, 20);
-                drawCenteredText(win, "Address : " + s.address,           top+175.f, 20);
-                drawCenteredText(win, "Year : " + s.year,                 top+205.f, 20);
-                drawCenteredText(win,
-                    "CGPA : " + to_string(s.cgpa).substr(0,4),
-                    top+235.f, 20, sf::Color(0,110,70));
-
-                drawCenteredText(win,
-                    "Press ESC to return to menu",
-                    top+cardH-40.f, 18, sf::Color(80,60,130));
-                break;
+bool readWarmStart(const string &path, WarmStart &w) {
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    while (getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        size_t sp = line.find(' ');
+        if (sp == string::npos) continue;
+        string key = line.substr(0, sp), value = line.substr(sp + 1);
+        if      (key == "font")    w.fontPath = value;
+        else if (key == "roster")  w.rosterPath = value;
+        else if (key == "subject") w.subjects.push_back(value);
+    }
+    return true;
+}
+
+// Write next to the target and rename over it, so a crash mid-write never
+// leaves half a file behind.
+bool writeFileAtomically(const string &path, const string &text) {
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp, ios::trunc);
+        out << text;
+        out.close();
+        if (!out) return false;
+    }
+    error_code ec;
+    filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+bool saveRosterFile(const string &path, const Roster &r) {
+    ostringstream out;
+    r.forEach([&](int roll, const Student &s) {
+        out << roll << '\t' << s.name << '\t' << s.dob << '\t' << s.address
+            << '\t' << s.year << '\t' << s.cgpa;
+        for (auto &sub : s.subjects)
+            out << '\t' << sub.name << '\t' << sub.total << '\t' << sub.present;
+        out << '\n';
+    });
+    return writeFileAtomically(path, out.str());
+}
+
+// Runs on a background thread while the menu is already up, so it only
+// builds its own Roster. Unreadable lines are skipped.
+Roster loadRosterFile(const string &path) {
+    ifstream in(path);
+    vector<pair<int, Student>> items;
+    string line;
+    while (getline(in, line)) {
+        vector<string> f;
+        istringstream ss(line);
+        for (string field; getline(ss, field, '\t'); ) f.push_back(field);
+        if (f.size() < 6 || (f.size() - 6) % 3 != 0) continue;
+        try {
+            Student s;
+            s.name    = f[1];
+            s.dob     = f[2];
+            s.address = f[3];
+            s.year    = f[4];
+            s.cgpa    = stof(f[5]);
+            for (size_t i = 6; i < f.size(); i += 3) {
+                SubjectInfo sub;
+                sub.name    = f[i];
+                sub.total   = stoi(f[i+1]);
+                sub.present = stoi(f[i+2]);
+                s.subjects.push_back(sub);
             }
+            items.push_back({stoi(f[0]), std::move(s)});
+        } catch (...) {
+        }
+    }
 
-            case Screen::VIEW_ATT_ROLL:
-                drawInputCard(win,
-                    "View Attendance Summary",
-                    "Enter Roll Number:",
-                    input);
-                break;
+    stable_sort(items.begin(), items.end(),
+                [](const pair<int, Student> &a, const pair<int, Student> &b) { return a.first < b.first; });
+    vector<pair<int, Student>> unique;   // last line wins for a repeated roll
+    for (auto &it : items) {
+        if (!unique.empty() && unique.back().first == it.first) unique.back() = std::move(it);
+        else unique.push_back(std::move(it));
+    }
+    return Roster::fromSorted(std::move(unique));
+}
 
-            case Screen::VIEW_ATT_SHOW: {
-                const Student &s = DB[currentRoll];
+// Saves the newest version, not the one on screen: closing the window after
+// an undo or while looking at an old version must not lose later saves.
+bool writeWarmStart(const string &path, const string &rosterPath) {
+    if (!saveRosterFile(rosterPath, roster.newest())) return false;
+    ostringstream out;
+    out << "font " << fontPath() << "\n"
+        << "roster " << rosterPath << "\n";
+    for (auto &name : subjectNames)
+        out << "subject " << name << "\n";
+    return writeFileAtomically(path, out.str());
+}
 
-                int totalC=0,totalP=0;
-                for (auto &sub: s.subjects) {
-                    totalC += sub.total;
-                    totalP += sub.present;
-                }
-                float overall = (totalC>0)?(100.f*totalP/totalC):0.f;
-
-                float cardW = min(820.f, win.getSize().x*0.95f);
-                float cardH = 520.f;
-                drawCardCentered(win, cardW, cardH);
-                float W = win.getSize().x;
-                float H = win.getSize().y;
-                float top = (H-cardH)/2.f;
-                float left = W/2.f - cardW/2.f + 40.f;
-
-                drawCenteredText(win, "Attendance Summary",
-                                 top+40.f, 26, sf::Color(60,0,110));
-
-                drawCenteredText(win,
-                    "Roll : " + to_string(currentRoll) +
-                    "   Name : " + s.name,
-                    top+80.f, 20);
-
-                drawCenteredText(win,
-                    "Overall Attendance : " +
-                    to_string(overall).substr(0,5) + "%",
-                    top+115.f, 22, sf::Color(0,120,70));
-
-                // Table header (ATT2 style)
-                float y = top + 160.f;
-                drawLeftText(win, "Subject",      left,       y, 20, sf::Color(40,0,80));
-                drawLeftText(win, "Total",        left+260.f, y, 20, sf::Color(40,0,80));
-                drawLeftText(win, "Present",      left+340.f, y, 20, sf::Color(40,0,80));
-                drawLeftText(win, "Percent",      left+440.f, y, 20, sf::Color(40,0,80));
-                y += 8.f;
-
-                // simple horizontal line
-                sf::RectangleShape line(sf::Vector2f(cardW-80.f, 2.f));
-                line.setPosition(left, y+14.f);
-                line.setFillColor(sf::Color(160,140,220));
-                win.draw(line);
-                y += 30.f;
-
-                for (auto &sub : s.subjects) {
-                    float per = (sub.total>0)?(100.f*sub.present/sub.total):0.f;
-                    drawLeftText(win, sub.name,                  left,       y, 18);
-                    drawLeftText(win, to_string(sub.total),      left+260.f, y, 18);
-                    drawLeftText(win, to_string(sub.present),    left+340.f, y, 18);
-                    drawLeftText(win, to_string(per).substr(0,5)+"%", left+440.f, y, 18);
-                    y += 26.f;
-                }
+// ============== STARTUP ==========================
 
-                drawCenteredText(win,
-                    "Press ESC to return to menu",
-                    top+cardH-40.f, 18, sf::Color(80,60,130));
-                break;
-            }
+const double STARTUP_BUDGET_MS = 250.0;   // menu must be usable by then
+const chrono::steady_clock::time_point processStart = chrono::steady_clock::now();
 
-            case Screen::PIE_ROLL:
-                drawInputCard(win,
-                    "Attendance Pie Chart",
-                    "Enter Roll Number:",
-                    input);
-                break;
+// Named moments since the process started, printed by --startup-report.
+struct StartupReport {
+    vector<pair<string, double>> marks;
+    double interactiveMs = 0.0;
+    bool setupRequired = false;   // first frame was subject setup, not the menu
 
-            case Screen::PIE_SHOW: {
-                const Student &s = DB[currentRoll];
+    void mark(const string &what) {
+        double t = chrono::duration<double, milli>(chrono::steady_clock::now() - processStart).count();
+        marks.push_back({what, t});
+    }
 
-                float cardW = min(820.f, win.getSize().x*0.95f);
-                float cardH = 550.f;
-                drawCardCentered(win, cardW, cardH);
+    void print() const {
+        cout << fixed << setprecision(1) << "startup phases   :\n";
+        double last = 0.0;
+        for (auto &m : marks) {
+            cout << "  " << setw(8) << m.second << " ms  (+" << setw(7) << m.second - last
+                 << ")  " << m.first << "\n";
+            last = m.second;
+        }
+        if (setupRequired) {
+            cout << "menu interactive : setup required (no warm start, subjects entered first)\n";
+            return;
+        }
+        cout << "menu interactive : " << interactiveMs << " ms (budget "
+             << STARTUP_BUDGET_MS << " ms, "
+             << (interactiveMs <= STARTUP_BUDGET_MS ? "met" : "missed") << ")\n";
+    }
+};
 
-                float H = win.getSize().y;
-                float top = (H-cardH)/2.f;
+// ============== MAIN =============================
 
-                drawCenteredText(win, "Attendance Pie Chart",
-                                 top+40.f, 26, sf::Color(60,0,110));
+int main(int argc, char **argv) {
+    string recordPath, replayPath, chartDir, fontArg, rosterArg;
+    string warmPath = "srms_warm.txt";
+    int synthetic = 0, threads = 0;
+    bool warmStart = true, startupReport = false;
+    vector<string> args(argv + 1, argv + argc);
+    for (size_t i = 0; i < args.size(); ++i) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--bench-versions")
+            return benchVersions(hasValue ? stoi(args[i+1]) : 10000);
+        if (args[i] == "--bench-search")
+            return benchSearch(hasValue ? stoi(args[i+1]) : 100000);
+        if      (args[i] == "--synthetic" && hasValue)     synthetic  = stoi(args[++i]);
+        else if (args[i] == "--replay" && hasValue)        replayPath = args[++i];
+        else if (args[i] == "--record" && hasValue)        recordPath = args[++i];
+        else if (args[i] == "--render-charts" && hasValue) chartDir   = args[++i];
+        else if (args[i] == "--roster" && hasValue)        rosterArg  = args[++i];
+        else if (args[i] == "--threads" && hasValue)       threads    = stoi(args[++i]);
+        else if (args[i] == "--font" && hasValue)          fontArg    = args[++i];
+        else if (args[i] == "--warm-start" && hasValue)    warmPath   = args[++i];
+        else if (args[i] == "--no-warm-start")             warmStart  = false;
+        else if (args[i] == "--startup-report")            startupReport = true;
+    }
+
+    // Fonts asked for explicitly beat everything else, in every mode.
+    size_t explicitFonts = 0;
+    if (const char *env = getenv("SRMS_FONT")) {
+        fontCandidates.insert(fontCandidates.begin(), env);
+        explicitFonts++;
+    }
+    if (!fontArg.empty()) {
+        fontCandidates.insert(fontCandidates.begin(), fontArg);
+        explicitFonts++;
+    }
+
+    // --render-charts exports the saved students unless it was given
+    // generated or replayed ones: --roster FILE, else the warm-start roster.
+    string chartRoster = rosterArg;
+    WarmStart saved;
+    if (!chartDir.empty() && chartRoster.empty() && synthetic == 0 && replayPath.empty() &&
+        warmStart && readWarmStart(warmPath, saved))
+        chartRoster = saved.rosterPath;
+    if (!chartDir.empty() && !chartRoster.empty()) {
+        if (!ifstream(chartRoster)) {
+            cerr << "Cannot open roster file " << chartRoster << "\n";
+            return 1;
+        }
+        roster.rebase(loadRosterFile(chartRoster));
+    }
 
-                drawCenteredText(win,
-                    "Roll : " + to_string(currentRoll) +
-                    "   Name : " + s.name,
-                    top+80.f, 20);
+    if (synthetic > 0) fillSyntheticRoster(synthetic);
+    if (!replayPath.empty()) {
+        int rc = runReplay(replayPath);
+        if (rc != 0 || chartDir.empty()) return rc;
+    }
+    if (!chartDir.empty()) return renderCharts(chartDir, threads);
+
+    // Only what the first menu frame needs happens before it; the saved
+    // roster loads on another thread and glyphs are prebaked between frames.
+    StartupReport startup;
+    // A recording must start where --replay does (subject setup), so it
+    // neither reads nor writes the warm-start file.
+    bool useWarm = warmStart && synthetic == 0 && recordPath.empty();
+    WarmStart warm;
+    if (useWarm && readWarmStart(warmPath, warm)) {
+        if (!warm.fontPath.empty())
+            fontCandidates.insert(fontCandidates.begin() + explicitFonts, warm.fontPath);
+        subjectNames = warm.subjects;
+    }
+    future<Roster> savedRoster;
+    if (!warm.rosterPath.empty())
+        savedRoster = async(launch::async, loadRosterFile, warm.rosterPath);
+    string rosterPath = warm.rosterPath.empty() ? warmPath + ".roster" : warm.rosterPath;
+    startup.mark("warm-start file read");
 
-                // PIE
-                drawPieChart(win, s);
+    startup.mark("font found: " + (fontPath().empty() ? string("(none)") : fontPath()));
 
-                // LEGEND
-                auto cols = pieColors();
-                float startY = top + 280.f;
-                float startX = win.getSize().x / 2.f - 260.f;
+    sf::RenderWindow win(sf::VideoMode(1000, 700),
+                         "Student Record Management System",
+                         sf::Style::Default);
+    win.setFramerateLimit(60);
+    sf::View view = win.getView();
+    startup.mark("window created");
 
-                int i = 0;
-                for (auto &sub : s.subjects) {
-                    float per = (sub.total>0) ? (100.f*sub.present/sub.total) : 0.f;
+    appFont();
+    startup.mark("font loaded");
 
-                    sf::RectangleShape box(sf::Vector2f(18.f,18.f));
-                    box.setFillColor(cols[i % cols.size()]);
-                    box.setPosition(startX, startY - 14.f);
-                    win.draw(box);
+    App app;
+    if (!subjectNames.empty()) app.screen = Screen::MENU;   // restored or --synthetic
+    app.rosterLoading = savedRoster.valid();
+    ReplayRecorder record;
+    if (!recordPath.empty() && !record.open(recordPath))
+        cerr << "Cannot write recording " << recordPath << "\n";
 
-                    string text = sub.name + "  →  " +
-                                  to_string(per).substr(0,5) + "%";
-                    drawLeftText(win, text, startX+30.f, startY-16.f, 18,
-                                 sf::Color::Black);
+    GlyphPrebake prebake;
+    bool firstFrame = true;
+    bool reported = !startupReport;
 
-                    startY += 26.f;
-                    i++;
-                }
+    while (win.isOpen()) {
+        sf::Event event;
+        while (win.pollEvent(event)) {
+            if (event.type == sf::Event::Closed)
+                win.close();
 
-                drawCenteredText(win,
-                    "Each color represents one subject and its attendance percentage",
-                    top+cardH-70.f, 18, sf::Color(40,0,80));
-                drawCenteredText(win,
-                    "Press ESC to return to menu",
-                    top+cardH-40.f, 18, sf::Color(80,60,130));
-                break;
+            if (event.type == sf::Event::Resized) {
+                view.setSize(event.size.width, event.size.height);
+                view.setCenter(event.size.width/2.f, event.size.height/2.f);
+                win.setView(view);
             }
+
+            app.handleEvent(event);
+            record.add(event);
         }
 
+        if (savedRoster.valid() &&
+            savedRoster.wait_for(chrono::seconds(0)) == future_status::ready)
+        {
+            // the saved roster is the base of the history, under anything
+            // saved while the file was still loading
+            Roster saved = savedRoster.get();
+            roster.rebase(saved);
+            app.rosterLoading = false;
+            startup.mark("saved roster loaded (" + to_string(saved.size()) + " students)");
+        }
+
+        app.update();
+        app.draw(win);
         win.display();
+        record.endFrame();
+
+        if (firstFrame) {
+            startup.mark("first frame drawn");
+            if (app.screen == Screen::MENU)
+                startup.interactiveMs = startup.marks.back().second;
+            else
+                startup.setupRequired = true;
+            firstFrame = false;
+        } else if (!prebake.done()) {
+            prebake.step(2.0);
+            if (prebake.done()) startup.mark("glyphs prebaked");
+        }
+
+        if (!reported && prebake.done() && !savedRoster.valid()) {
+            startup.print();
+            reported = true;
+        }
     }
 
+    bool setupDone = app.screen != Screen::SUBJECT_COUNT &&
+                     app.screen != Screen::SUBJECT_NAME;
+    if (useWarm && setupDone && !app.rosterLoading &&
+        !writeWarmStart(warmPath, rosterPath))
+        cerr << "Could not write warm-start file " << warmPath << "\n";
+
     return 0;
 }